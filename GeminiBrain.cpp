@@ -1,6 +1,29 @@
 #include "GeminiBrain.h"
 #include <QDebug>
 #include <QUrl>
+#include <QHash>
+#include <QTimer>
+#include <QPointer>
+#include <QElapsedTimer>
+#include <algorithm>
+
+static const qint64 MIN_HEDGE_MS = 300;
+
+struct GeminiBrain::Exchange {
+    struct Attempt {
+        int backend = -1;
+        qint64 startedMs = 0;
+        bool timedOut = false;
+    };
+
+    QJsonObject body;
+    QList<int> order;                        // backend indices, best first
+    int next = 0;                            // next entry of order to try
+    QHash<QNetworkReply *, Attempt> inFlight;
+    QPointer<QTimer> hedgeTimer;
+    QElapsedTimer clock;
+    bool done = false;
+};
 
 GeminiBrain::GeminiBrain(QObject *parent) : QObject(parent) {
     manager = new QNetworkAccessManager(this);
@@ -9,22 +32,176 @@ GeminiBrain::GeminiBrain(QObject *parent) : QObject(parent) {
 const QString API_KEY;
 void GeminiBrain::setApiKey(const QString &key) {
     m_apiKey = key;
+    for (LlmBackend &b : backends) {
+        if (b.needsKey) b.apiKey = key;
+    }
     qDebug() << "🔑 API Key set successfully.";
 }
 
+void GeminiBrain::addBackend(const LlmBackend &backend) {
+    LlmBackend b = backend;
+    if (b.needsKey && b.apiKey.isEmpty()) b.apiKey = m_apiKey;
+    if (b.timeoutMs <= 0) b.timeoutMs = 20000;
+    backends.append(b);
+    qDebug() << "🧠 Backend:" << b.name << b.endpoint.toString() << b.model;
+
+    // The key can still arrive later; a bad URL or model can't fix itself
+    if (!b.hasValidEndpoint()) qWarning() << "⚠️ Ignoring backend" << b.name << "- URL needs http(s)://host:" << b.endpoint.toString();
+    else if (b.model.isEmpty()) qWarning() << "⚠️ Ignoring backend" << b.name << "- no model set";
+}
+
+// True unless some backend can answer without the OpenAI key
+bool GeminiBrain::needsApiKey() const {
+    for (const LlmBackend &b : backends) {
+        if (!b.needsKey && b.isUsable()) return false;
+    }
+    return true;
+}
 
 void GeminiBrain::sendMessage(const QString &text) {
     qDebug() << "🧠 Sending to AI:" << text;
 
-    if (m_apiKey.isEmpty()) {
-        emit responseReceived("I am missing my API Key, sir.");
+    auto ex = QSharedPointer<Exchange>::create();
+    ex->order = routeOrder();
+    if (ex->order.isEmpty()) {
+        // Only blame the key if it's the one thing keeping a backend out
+        bool keyMissing = false;
+        for (const LlmBackend &b : backends) {
+            if (b.needsKey && b.apiKey.isEmpty() && b.hasValidEndpoint() && !b.model.isEmpty()) keyMissing = true;
+        }
+        if (keyMissing) emit responseReceived("I am missing my API Key, sir.");
+        else emit responseReceived("I have no working AI backend configured, sir.");
         return;
     }
 
-    QNetworkRequest req(QUrl("https://api.openai.com/v1/chat/completions"));
+    ex->body = buildBody(text);
+    ex->clock.start();
+    launchNext(ex);
+}
+
+// Healthy backends first, then fastest p95 latency (config order on ties)
+QList<int> GeminiBrain::routeOrder() const {
+    QList<int> order;
+    for (int i = 0; i < backends.size(); ++i) {
+        if (backends[i].isUsable()) order.append(i);
+    }
+    std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+        const LlmBackend &A = backends[a];
+        const LlmBackend &B = backends[b];
+        if (A.isHealthy() != B.isHealthy()) return A.isHealthy();
+        return A.p95() < B.p95();
+    });
+    return order;
+}
+
+bool GeminiBrain::launchNext(const QSharedPointer<Exchange> &ex) {
+    if (ex->done || ex->next >= ex->order.size()) return false;
+
+    int idx = ex->order[ex->next++];
+    const LlmBackend &b = backends[idx];
+
+    QNetworkRequest req(b.endpoint);
     req.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
-    req.setRawHeader("Authorization", ("Bearer " + m_apiKey).toUtf8());
+    if (!b.apiKey.isEmpty()) req.setRawHeader("Authorization", ("Bearer " + b.apiKey).toUtf8());
+
+    QJsonObject root = ex->body;
+    root["model"] = b.model;
+
+    qDebug() << "📡 Asking" << b.name;
+    QNetworkReply *reply = manager->post(req, QJsonDocument(root).toJson());
+
+    Exchange::Attempt attempt;
+    attempt.backend = idx;
+    attempt.startedMs = ex->clock.elapsed();
+    ex->inFlight.insert(reply, attempt);
+
+    connect(reply, &QNetworkReply::finished, this, [this, ex, reply](){ onFinished(ex, reply); });
+
+    // DEADLINE: abort counts as a failure for this backend
+    QTimer::singleShot(b.timeoutMs, reply, [ex, reply](){
+        qDebug() << "⏱️ Deadline hit, aborting.";
+        auto it = ex->inFlight.find(reply);
+        if (it != ex->inFlight.end()) it->timedOut = true;
+        reply->abort();
+    });
+
+    // HEDGE: no answer by this backend's p95 -> also ask the next one
+    if (ex->next < ex->order.size()) {
+        if (!ex->hedgeTimer) {
+            ex->hedgeTimer = new QTimer(this);
+            ex->hedgeTimer->setSingleShot(true);
+            connect(ex->hedgeTimer, &QTimer::timeout, this, [this, ex](){
+                if (ex->done) return;
+                qDebug() << "🔀 Slow answer, hedging.";
+                launchNext(ex);
+            });
+        }
+        qint64 delay = qMax(MIN_HEDGE_MS, qMin(b.p95(), qint64(b.timeoutMs)));
+        ex->hedgeTimer->start(int(delay));
+    }
+    return true;
+}
+
+void GeminiBrain::onFinished(const QSharedPointer<Exchange> &ex, QNetworkReply *reply) {
+    reply->deleteLater();
+    if (!ex->inFlight.contains(reply)) return;
+    Exchange::Attempt attempt = ex->inFlight.take(reply);
+
+    // Loser we cancelled ourselves
+    if (ex->done) return;
+
+    LlmBackend &b = backends[attempt.backend];
+    qint64 tookMs = ex->clock.elapsed() - attempt.startedMs;
+    int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+    // Error replies (4xx/5xx, refused, ...) and 2xx replies we can't act on
+    // only count as failures, never as latency, so a backend that fails fast
+    // doesn't look fast
+    QJsonObject message;
+    bool ok = !reply->error() && status >= 200 && status < 300;
+    if (ok) {
+        message = usableMessage(reply->readAll());
+        ok = !message.isEmpty();
+    }
 
+    if (!ok) {
+        QString why = reply->error() ? reply->errorString() : QString("unusable reply body");
+        qDebug() << "❌ ERROR:" << b.name << status << why;
+        if (attempt.timedOut) b.recordLatency(tookMs); // at least this slow
+        b.recordFailure();
+
+        // Still waiting on a hedge? let it finish. Otherwise fail over.
+        if (!ex->inFlight.isEmpty()) return;
+        if (launchNext(ex)) return;
+
+        ex->done = true;
+        if (ex->hedgeTimer) ex->hedgeTimer->deleteLater();
+        emit responseReceived("I can't reach my brain right now, sir.");
+        return;
+    }
+
+    b.recordLatency(tookMs);
+    b.recordSuccess();
+    ex->done = true;
+    if (ex->hedgeTimer) ex->hedgeTimer->deleteLater();
+
+    // Cancel the losers (their finished() lands in the ex->done branch above).
+    // A loser started before the winner was overtaken: it is at least as slow
+    // as it has been so far, so record that and let routing demote it.
+    // A hedge that lost to an earlier request tells us nothing.
+    const QList<QNetworkReply *> losers = ex->inFlight.keys();
+    for (QNetworkReply *other : losers) {
+        const Exchange::Attempt &lost = ex->inFlight[other];
+        if (lost.startedMs < attempt.startedMs) {
+            backends[lost.backend].recordLatency(ex->clock.elapsed() - lost.startedMs);
+        }
+        other->abort();
+    }
+
+    handleReply(message);
+}
+
+QJsonObject GeminiBrain::buildBody(const QString &text) const {
     // 1. SYSTEM PROMPT
     QJsonObject systemMsg;
     systemMsg["role"] = "system";
@@ -79,59 +256,49 @@ void GeminiBrain::sendMessage(const QString &text) {
     tools.append(QJsonObject{{"type", "function"}, {"function", closeAppFunc}}); // Add to list
     tools.append(QJsonObject{{"type", "function"}, {"function", openWebFunc}});
 
+    // "model" is filled in per backend
     QJsonObject root;
-    root["model"] = "gpt-4o-mini";
     root["messages"] = messages;
     root["tools"] = tools;
     root["tool_choice"] = "auto";
+    return root;
+}
 
-    QByteArray data = QJsonDocument(root).toJson();
-    QNetworkReply *reply = manager->post(req, data);
+// choices[0].message, or an empty object if there is nothing to act on
+// (not JSON, no choices, neither tool calls nor text)
+QJsonObject GeminiBrain::usableMessage(const QByteArray &rawData) {
+    QJsonObject resp = QJsonDocument::fromJson(rawData).object();
+    QJsonArray choices = resp["choices"].toArray();
+    if (choices.isEmpty()) return QJsonObject();
 
-    connect(reply, &QNetworkReply::finished, this, [this, reply](){
-        handleReply(reply);
-    });
+    QJsonObject message = choices[0].toObject()["message"].toObject();
+    if (!message["tool_calls"].toArray().isEmpty()) return message;
+    if (!message["content"].toString().isEmpty()) return message;
+    return QJsonObject();
 }
 
-void GeminiBrain::handleReply(QNetworkReply *reply) {
-    if(reply->error()) {
-        qDebug() << "❌ ERROR:" << reply->errorString();
-        reply->deleteLater();
-        return;
-    }
+// message comes from usableMessage(), so exactly one response goes out
+void GeminiBrain::handleReply(const QJsonObject &message) {
+    if(!message["tool_calls"].toArray().isEmpty()) {
+        QJsonArray toolCalls = message["tool_calls"].toArray();
+        for(const QJsonValue &val : toolCalls) {
+            QJsonObject tool = val.toObject();
+            QJsonObject func = tool["function"].toObject();
+            QString name = func["name"].toString();
+            QString argsStr = func["arguments"].toString();
+            QJsonObject args = QJsonDocument::fromJson(argsStr.toUtf8()).object();
 
-    QByteArray rawData = reply->readAll();
-    QJsonObject resp = QJsonDocument::fromJson(rawData).object();
+            qDebug() << "⚡ EXECUTE:" << name;
 
-    if(resp.contains("choices")) {
-        QJsonArray choices = resp["choices"].toArray();
-        if(!choices.isEmpty()) {
-            QJsonObject message = choices[0].toObject()["message"].toObject();
-
-            if(message.contains("tool_calls")) {
-                QJsonArray toolCalls = message["tool_calls"].toArray();
-                for(const QJsonValue &val : toolCalls) {
-                    QJsonObject tool = val.toObject();
-                    QJsonObject func = tool["function"].toObject();
-                    QString name = func["name"].toString();
-                    QString argsStr = func["arguments"].toString();
-                    QJsonObject args = QJsonDocument::fromJson(argsStr.toUtf8()).object();
-
-                    qDebug() << "⚡ EXECUTE:" << name;
-
-                    if(name == "open_app") emit actionTriggered("open", args["appName"].toString());
-                    if(name == "open_website") emit actionTriggered("web", args["url"].toString());
-
-                    // NEW: TRIGGER CLOSE
-                    if(name == "close_app") emit actionTriggered("close", args["appName"].toString());
-                }
-                emit responseReceived("Done.");
-            }
-            else if(message.contains("content")) {
-                QString text = message["content"].toString();
-                if(!text.isEmpty()) emit responseReceived(text);
-            }
+            if(name == "open_app") emit actionTriggered("open", args["appName"].toString());
+            if(name == "open_website") emit actionTriggered("web", args["url"].toString());
+
+            // NEW: TRIGGER CLOSE
+            if(name == "close_app") emit actionTriggered("close", args["appName"].toString());
         }
+        emit responseReceived("Done.");
+    }
+    else {
+        emit responseReceived(message["content"].toString());
     }
-    reply->deleteLater();
 }
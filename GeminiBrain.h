@@ -5,19 +5,34 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
+#include <QSharedPointer>
+#include <QVector>
+#include "LlmBackend.h"
 
 class GeminiBrain : public QObject {
     Q_OBJECT
 public:
     explicit GeminiBrain(QObject *parent = nullptr);
     void setApiKey(const QString &key);
+    void addBackend(const LlmBackend &backend);
+    const QVector<LlmBackend> &backendStats() const { return backends; }
+    bool needsApiKey() const;
     void sendMessage(const QString &text);
 signals:
     void responseReceived(const QString &text);
     void actionTriggered(const QString &type, const QString &val);
 private:
+    struct Exchange; // one user message, possibly sent to several backends
+
     QNetworkAccessManager *manager;
     QJsonArray history;
     QString m_apiKey;
-    void handleReply(QNetworkReply *reply);
+    QVector<LlmBackend> backends;
+
+    QJsonObject buildBody(const QString &text) const;
+    QList<int> routeOrder() const;
+    bool launchNext(const QSharedPointer<Exchange> &ex);
+    void onFinished(const QSharedPointer<Exchange> &ex, QNetworkReply *reply);
+    static QJsonObject usableMessage(const QByteArray &rawData);
+    void handleReply(const QJsonObject &message);
 };
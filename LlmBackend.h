@@ -0,0 +1,66 @@
+#pragma once
+#include <QString>
+#include <QUrl>
+#include <QVector>
+#include <QDateTime>
+#include <algorithm>
+
+// One OpenAI-compatible chat endpoint (cloud or LAN server) + its health stats
+struct LlmBackend {
+    QString name;
+    QUrl endpoint;
+    QString model;
+    QString apiKey;
+    bool needsKey = true;   // local servers usually don't check the key
+    int timeoutMs = 20000;  // hard deadline for a single request
+    int coldHedgeMs = 8000; // hedge delay until we have latency history
+
+    // --- HEALTH / LATENCY ---
+    // Total time to a complete, usable reply (we don't stream, so there is no
+    // earlier "first byte"). Requests we gave up on add a lower bound.
+    QVector<qint64> latencyMs;
+    int failures = 0;     // consecutive failures
+    qint64 downUntil = 0; // epoch ms, routed last until then
+
+    // "localhost:8080/..." or "foo" are valid QUrls too, so insist on http(s)://host
+    bool hasValidEndpoint() const {
+        QString scheme = endpoint.scheme();
+        return endpoint.isValid() && (scheme == "http" || scheme == "https") && !endpoint.host().isEmpty();
+    }
+
+    bool isUsable() const {
+        return hasValidEndpoint() && !model.isEmpty() && (!needsKey || !apiKey.isEmpty());
+    }
+
+    bool isHealthy() const {
+        return QDateTime::currentMSecsSinceEpoch() >= downUntil;
+    }
+
+    // p95 of recent latency (coldHedgeMs until we have enough samples)
+    qint64 p95() const {
+        if (latencyMs.size() < 5) return coldHedgeMs;
+        QVector<qint64> sorted = latencyMs;
+        std::sort(sorted.begin(), sorted.end());
+        int idx = (sorted.size() * 95 + 99) / 100 - 1;
+        return sorted[qBound(0, idx, int(sorted.size()) - 1)];
+    }
+
+    void recordLatency(qint64 ms) {
+        latencyMs.append(ms);
+        if (latencyMs.size() > 32) latencyMs.removeFirst();
+    }
+
+    void recordSuccess() {
+        failures = 0;
+        downUntil = 0;
+    }
+
+    // 3 strikes -> back off 5s, 10s, 20s ... capped at 80s
+    void recordFailure() {
+        failures++;
+        if (failures >= 3) {
+            int shift = qMin(failures - 3, 4);
+            downUntil = QDateTime::currentMSecsSinceEpoch() + (5000LL << shift);
+        }
+    }
+};
@@ -11,16 +11,49 @@
 #include <QMenu>
 #include <QContextMenuEvent>
 
+// Env var or saved setting in ms. Junk/zero would abort every request instantly.
+static int timeoutSetting(const QSettings &settings, const char *envName, const QString &key) {
+    bool ok = false;
+    int ms = qEnvironmentVariable(envName, settings.value(key).toString()).toInt(&ok);
+    return (ok && ms > 0) ? ms : 20000;
+}
+
 Friday::Friday(QWidget *parent) : QMainWindow(parent) {
     setupUI();
     voice = new QTextToSpeech(this);
     brain = new GeminiBrain(this);
     ear = new VoiceEar(this);
 
+    QSettings settings("FridayCorp", "FridayAssistant");
+
+    // ==========================================
+    // 🧠 LLM BACKENDS (Cloud + optional LAN server)
+    // ==========================================
+    // Any OpenAI-compatible /v1/chat/completions endpoint works.
+    // Env vars win over saved settings, same as the API key.
+    LlmBackend cloud;
+    cloud.name = "openai";
+    cloud.endpoint = QUrl(qEnvironmentVariable("FRIDAY_LLM_URL",
+        settings.value("llm_url", "https://api.openai.com/v1/chat/completions").toString()));
+    cloud.model = qEnvironmentVariable("FRIDAY_LLM_MODEL", settings.value("llm_model", "gpt-4o-mini").toString());
+    cloud.timeoutMs = timeoutSetting(settings, "FRIDAY_LLM_TIMEOUT_MS", "llm_timeout_ms");
+    brain->addBackend(cloud);
+
+    QString localUrl = qEnvironmentVariable("FRIDAY_LOCAL_LLM_URL", settings.value("local_llm_url").toString());
+    if (!localUrl.isEmpty()) {
+        LlmBackend local;
+        local.name = "local";
+        local.endpoint = QUrl(localUrl);
+        local.model = qEnvironmentVariable("FRIDAY_LOCAL_LLM_MODEL", settings.value("local_llm_model", "local").toString());
+        local.apiKey = qEnvironmentVariable("FRIDAY_LOCAL_LLM_KEY", settings.value("local_llm_key").toString());
+        local.needsKey = false;
+        local.timeoutMs = timeoutSetting(settings, "FRIDAY_LOCAL_LLM_TIMEOUT_MS", "local_llm_timeout_ms");
+        brain->addBackend(local);
+    }
+
     // ==========================================
     // 🔑 API KEY LOGIC (Startup Check)
     // ==========================================
-    QSettings settings("FridayCorp", "FridayAssistant");
     QString finalKey = "";
 
     // 1. Check Env Var (Priority for Developers)
@@ -35,7 +68,8 @@ Friday::Friday(QWidget *parent) : QMainWindow(parent) {
     }
 
     // 3. Validation: If key is missing or looks wrong, FORCE PROMPT
-    if (finalKey.isEmpty() || !finalKey.startsWith("sk-")) {
+    //    (unless a keyless LAN backend can answer without it)
+    if (brain->needsApiKey() && (finalKey.isEmpty() || !finalKey.startsWith("sk-"))) {
         bool ok;
         QString text = QInputDialog::getText(this, "Friday Setup",
                                              "Please enter your OpenAI API Key (sk-...):",
@@ -49,7 +83,7 @@ Friday::Friday(QWidget *parent) : QMainWindow(parent) {
 
     // 4. Send to Brain
     if (finalKey.isEmpty()) {
-        voice->say("I need an API key to function, sir.");
+        if (brain->needsApiKey()) voice->say("I need an API key to function, sir.");
     } else {
         brain->setApiKey(finalKey);
     }
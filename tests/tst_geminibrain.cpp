@@ -0,0 +1,284 @@
+#include <QtTest>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QPointer>
+#include "GeminiBrain.h"
+
+// Tiny OpenAI-compatible endpoint on localhost.
+// delayMs < 0 means it never answers (a stalled backend).
+class StubLlm : public QObject {
+public:
+    int delayMs = 0;
+    int status = 200;
+    QString content;
+    QByteArray rawBody; // sent as-is instead of a chat completion when set
+    int hits = 0;    // complete requests received
+    int aborted = 0; // client hung up before we answered
+
+    explicit StubLlm(const QString &answer, QObject *parent = nullptr)
+        : QObject(parent), content(answer) {
+        server.listen(QHostAddress::LocalHost, 0);
+        connect(&server, &QTcpServer::newConnection, this, [this](){
+            while (QTcpSocket *s = server.nextPendingConnection()) serve(s);
+        });
+    }
+
+    QUrl url() const {
+        return QUrl(QString("http://127.0.0.1:%1/v1/chat/completions").arg(server.serverPort()));
+    }
+
+private:
+    QTcpServer server;
+
+    void serve(QTcpSocket *s) {
+        auto buf = QSharedPointer<QByteArray>::create();
+        auto answered = QSharedPointer<bool>::create(false);
+        auto started = QSharedPointer<bool>::create(false);
+
+        connect(s, &QTcpSocket::readyRead, this, [this, s, buf, answered, started](){
+            buf->append(s->readAll());
+            int headerEnd = buf->indexOf("\r\n\r\n");
+            if (*started || headerEnd < 0) return;
+
+            qsizetype length = 0;
+            for (const QByteArray &line : buf->left(headerEnd).split('\n')) {
+                if (line.toLower().startsWith("content-length:")) length = line.mid(15).trimmed().toLongLong();
+            }
+            if (buf->size() < headerEnd + 4 + length) return;
+
+            *started = true;
+            hits++;
+            if (delayMs < 0) return;
+
+            QPointer<QTcpSocket> sock(s);
+            QTimer::singleShot(delayMs, this, [this, sock, answered](){
+                if (!sock || sock->state() != QAbstractSocket::ConnectedState) return;
+                QJsonObject message{{"role", "assistant"}, {"content", content}};
+                QJsonObject choice{{"message", message}};
+                QJsonObject root{{"choices", QJsonArray{choice}}};
+                QByteArray body = rawBody.isEmpty() ? QJsonDocument(root).toJson() : rawBody;
+
+                QByteArray head = "HTTP/1.1 " + QByteArray::number(status) + " Stub\r\n"
+                                  "Content-Type: application/json\r\n"
+                                  "Connection: close\r\n"
+                                  "Content-Length: " + QByteArray::number(body.size()) + "\r\n\r\n";
+                *answered = true;
+                sock->write(head + body);
+                sock->disconnectFromHost();
+            });
+        });
+        connect(s, &QTcpSocket::disconnected, this, [this, s, answered, started](){
+            if (*started && !*answered) aborted++;
+            s->deleteLater();
+        });
+    }
+};
+
+class TestGeminiBrain : public QObject {
+    Q_OBJECT
+private slots:
+    void answersFromSingleBackend();
+    void hedgeWinsAndLoserIsAborted();
+    void overtakenBackendIsDemoted();
+    void deadlineEndsInSpokenError();
+    void errorStatusFailsOverWithoutLatencySample();
+    void emptyBodyFailsOverWithoutLatencySample();
+    void emptyBodyFromOnlyBackendEndsInSpokenError();
+    void missingKeyUnlessKeylessBackend();
+    void badConfigIsNotBlamedOnKey();
+
+private:
+    static LlmBackend stubBackend(const QString &name, const StubLlm &stub) {
+        LlmBackend b;
+        b.name = name;
+        b.endpoint = stub.url();
+        b.model = "stub";
+        b.needsKey = false;
+        b.timeoutMs = 5000;
+        b.coldHedgeMs = 300;
+        return b;
+    }
+};
+
+void TestGeminiBrain::answersFromSingleBackend() {
+    StubLlm stub("hello sir");
+    GeminiBrain brain;
+    brain.addBackend(stubBackend("only", stub));
+    QSignalSpy spy(&brain, &GeminiBrain::responseReceived);
+
+    brain.sendMessage("hi");
+    QTRY_COMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).toString(), QString("hello sir"));
+    QCOMPARE(stub.hits, 1);
+    QCOMPARE(brain.backendStats()[0].latencyMs.size(), 1);
+}
+
+void TestGeminiBrain::hedgeWinsAndLoserIsAborted() {
+    StubLlm slow("slow");
+    slow.delayMs = -1;
+    StubLlm fast("fast");
+
+    GeminiBrain brain;
+    brain.addBackend(stubBackend("slow", slow));
+    brain.addBackend(stubBackend("fast", fast));
+    QSignalSpy spy(&brain, &GeminiBrain::responseReceived);
+
+    brain.sendMessage("hi");
+    QTRY_COMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).toString(), QString("fast"));
+    QCOMPARE(slow.hits, 1);
+    QCOMPARE(fast.hits, 1);
+    QTRY_COMPARE(slow.aborted, 1);
+
+    // The cancelled loser must not produce a second answer
+    QTest::qWait(300);
+    QCOMPARE(spy.count(), 1);
+
+    // Overtaken primary records a lower bound around the hedge delay
+    const LlmBackend &loser = brain.backendStats()[0];
+    QCOMPARE(loser.latencyMs.size(), 1);
+    QVERIFY(loser.latencyMs[0] >= 250);
+    QCOMPARE(loser.failures, 0);
+}
+
+void TestGeminiBrain::overtakenBackendIsDemoted() {
+    StubLlm slow("slow");
+    slow.delayMs = -1;
+    StubLlm fast("fast");
+
+    // Long fast history, then it stalls
+    LlmBackend a = stubBackend("was-fast", slow);
+    for (int i = 0; i < 32; ++i) a.recordLatency(50);
+    LlmBackend b = stubBackend("fast", fast);
+    b.coldHedgeMs = 100;
+
+    GeminiBrain brain;
+    brain.addBackend(a);
+    brain.addBackend(b);
+    QSignalSpy spy(&brain, &GeminiBrain::responseReceived);
+
+    for (int round = 1; round <= 2; ++round) {
+        brain.sendMessage("hi");
+        QTRY_COMPARE(spy.count(), round);
+        QCOMPARE(slow.hits, round);
+    }
+    QVERIFY(brain.backendStats()[0].p95() >= 250);
+
+    // Now the fast one is asked first and the stalled one is left alone
+    brain.sendMessage("hi");
+    QTRY_COMPARE(spy.count(), 3);
+    QCOMPARE(spy.at(2).at(0).toString(), QString("fast"));
+    QTest::qWait(400);
+    QCOMPARE(slow.hits, 2);
+}
+
+void TestGeminiBrain::deadlineEndsInSpokenError() {
+    StubLlm stalled("never");
+    stalled.delayMs = -1;
+
+    LlmBackend b = stubBackend("stalled", stalled);
+    b.timeoutMs = 200;
+    GeminiBrain brain;
+    brain.addBackend(b);
+    QSignalSpy spy(&brain, &GeminiBrain::responseReceived);
+
+    brain.sendMessage("hi");
+    QTRY_COMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).toString(), QString("I can't reach my brain right now, sir."));
+    QTRY_COMPARE(stalled.aborted, 1);
+
+    const LlmBackend &stats = brain.backendStats()[0];
+    QCOMPARE(stats.failures, 1);
+    QCOMPARE(stats.latencyMs.size(), 1);
+    QVERIFY(stats.latencyMs[0] >= 180);
+}
+
+void TestGeminiBrain::errorStatusFailsOverWithoutLatencySample() {
+    StubLlm broken("oops");
+    broken.status = 500;
+    StubLlm fine("fine");
+
+    GeminiBrain brain;
+    brain.addBackend(stubBackend("broken", broken));
+    brain.addBackend(stubBackend("fine", fine));
+    QSignalSpy spy(&brain, &GeminiBrain::responseReceived);
+
+    brain.sendMessage("hi");
+    QTRY_COMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).toString(), QString("fine"));
+
+    const LlmBackend &stats = brain.backendStats()[0];
+    QCOMPARE(stats.failures, 1);
+    QVERIFY(stats.latencyMs.isEmpty());
+}
+
+void TestGeminiBrain::emptyBodyFailsOverWithoutLatencySample() {
+    StubLlm hollow("unused");
+    hollow.rawBody = "{}";
+    StubLlm fine("fine");
+
+    GeminiBrain brain;
+    brain.addBackend(stubBackend("hollow", hollow));
+    brain.addBackend(stubBackend("fine", fine));
+    QSignalSpy spy(&brain, &GeminiBrain::responseReceived);
+
+    brain.sendMessage("hi");
+    QTRY_COMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).toString(), QString("fine"));
+    QCOMPARE(fine.hits, 1);
+
+    const LlmBackend &stats = brain.backendStats()[0];
+    QCOMPARE(stats.failures, 1);
+    QVERIFY(stats.latencyMs.isEmpty());
+
+    QTest::qWait(400);
+    QCOMPARE(spy.count(), 1);
+}
+
+void TestGeminiBrain::emptyBodyFromOnlyBackendEndsInSpokenError() {
+    StubLlm hollow("");
+    GeminiBrain brain;
+    brain.addBackend(stubBackend("hollow", hollow));
+    QSignalSpy spy(&brain, &GeminiBrain::responseReceived);
+
+    brain.sendMessage("hi");
+    QTRY_COMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).toString(), QString("I can't reach my brain right now, sir."));
+}
+
+void TestGeminiBrain::missingKeyUnlessKeylessBackend() {
+    GeminiBrain brain;
+    LlmBackend cloud;
+    cloud.name = "openai";
+    cloud.endpoint = QUrl("https://api.openai.com/v1/chat/completions");
+    cloud.model = "gpt-4o-mini";
+    brain.addBackend(cloud);
+    QVERIFY(brain.needsApiKey());
+
+    QSignalSpy spy(&brain, &GeminiBrain::responseReceived);
+    brain.sendMessage("hi");
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).toString(), QString("I am missing my API Key, sir."));
+
+    StubLlm local("local");
+    brain.addBackend(stubBackend("local", local));
+    QVERIFY(!brain.needsApiKey());
+}
+
+void TestGeminiBrain::badConfigIsNotBlamedOnKey() {
+    GeminiBrain brain;
+    brain.setApiKey("sk-test");
+    LlmBackend cloud;
+    cloud.name = "openai";
+    cloud.endpoint = QUrl("api.openai.com/v1/chat/completions"); // no scheme
+    cloud.model = "gpt-4o-mini";
+    brain.addBackend(cloud);
+
+    QSignalSpy spy(&brain, &GeminiBrain::responseReceived);
+    brain.sendMessage("hi");
+    QCOMPARE(spy.count(), 1);
+    QCOMPARE(spy.at(0).at(0).toString(), QString("I have no working AI backend configured, sir."));
+}
+
+QTEST_GUILESS_MAIN(TestGeminiBrain)
+#include "tst_geminibrain.moc"
@@ -0,0 +1,121 @@
+#include <QtTest>
+#include "LlmBackend.h"
+
+class TestLlmBackend : public QObject {
+    Q_OBJECT
+private slots:
+    void p95UsesColdDefaultUntilFiveSamples();
+    void p95PicksNinetyFifthPercentile();
+    void latencyWindowKeepsLast32();
+    void failuresBackOffAfterThreeStrikes();
+    void backoffIsCapped();
+    void successResetsHealth();
+    void usableNeedsKeyOnlyWhenAsked();
+    void usableNeedsHttpSchemeAndHost();
+};
+
+void TestLlmBackend::p95UsesColdDefaultUntilFiveSamples() {
+    LlmBackend b;
+    b.coldHedgeMs = 1234;
+    for (int i = 0; i < 4; ++i) b.recordLatency(10);
+    QCOMPARE(b.p95(), qint64(1234));
+
+    b.recordLatency(10);
+    QCOMPARE(b.p95(), qint64(10));
+}
+
+void TestLlmBackend::p95PicksNinetyFifthPercentile() {
+    LlmBackend b;
+    for (int i = 20; i >= 1; --i) b.recordLatency(i); // order shouldn't matter
+    QCOMPARE(b.p95(), qint64(19));
+
+    LlmBackend five;
+    for (qint64 ms : {100, 200, 300, 400, 5000}) five.recordLatency(ms);
+    QCOMPARE(five.p95(), qint64(5000));
+}
+
+void TestLlmBackend::latencyWindowKeepsLast32() {
+    LlmBackend b;
+    for (int i = 0; i < 40; ++i) b.recordLatency(i);
+    QCOMPARE(b.latencyMs.size(), 32);
+    QCOMPARE(b.latencyMs.first(), qint64(8));
+    QCOMPARE(b.latencyMs.last(), qint64(39));
+}
+
+void TestLlmBackend::failuresBackOffAfterThreeStrikes() {
+    LlmBackend b;
+    b.recordFailure();
+    b.recordFailure();
+    QVERIFY(b.isHealthy());
+
+    qint64 before = QDateTime::currentMSecsSinceEpoch();
+    b.recordFailure();
+    QVERIFY(!b.isHealthy());
+    QVERIFY(b.downUntil >= before + 5000);
+    QVERIFY(b.downUntil <= QDateTime::currentMSecsSinceEpoch() + 5000);
+
+    b.recordFailure();
+    QVERIFY(b.downUntil >= before + 10000);
+}
+
+void TestLlmBackend::backoffIsCapped() {
+    LlmBackend b;
+    for (int i = 0; i < 100; ++i) b.recordFailure();
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    QVERIFY(b.downUntil > now + 70000);
+    QVERIFY(b.downUntil <= now + 80000);
+}
+
+void TestLlmBackend::successResetsHealth() {
+    LlmBackend b;
+    for (int i = 0; i < 5; ++i) b.recordFailure();
+    QVERIFY(!b.isHealthy());
+
+    b.recordSuccess();
+    QVERIFY(b.isHealthy());
+    QCOMPARE(b.failures, 0);
+}
+
+void TestLlmBackend::usableNeedsKeyOnlyWhenAsked() {
+    LlmBackend b;
+    b.endpoint = QUrl("http://127.0.0.1:8080/v1/chat/completions");
+    b.model = "local";
+    QVERIFY(!b.isUsable());
+
+    b.needsKey = false;
+    QVERIFY(b.isUsable());
+
+    b.needsKey = true;
+    b.apiKey = "sk-test";
+    QVERIFY(b.isUsable());
+
+    // A key doesn't rescue a URL without a scheme
+    b.endpoint = QUrl("127.0.0.1:8080/v1/chat/completions");
+    QVERIFY(!b.isUsable());
+}
+
+void TestLlmBackend::usableNeedsHttpSchemeAndHost() {
+    LlmBackend b;
+    b.model = "local";
+    b.needsKey = false;
+
+    // Valid QUrls, but "localhost" is parsed as the scheme / "foo" is relative
+    b.endpoint = QUrl("localhost:8080/v1/chat/completions");
+    QVERIFY(b.endpoint.isValid());
+    QVERIFY(!b.isUsable());
+
+    b.endpoint = QUrl("foo");
+    QVERIFY(!b.isUsable());
+
+    b.endpoint = QUrl("ftp://10.0.0.5/v1/chat/completions");
+    QVERIFY(!b.isUsable());
+
+    b.endpoint = QUrl("https://10.0.0.5:8443/v1/chat/completions");
+    QVERIFY(b.isUsable());
+
+    b.model.clear();
+    QVERIFY(!b.isUsable());
+}
+
+QTEST_GUILESS_MAIN(TestLlmBackend)
+#include "tst_llmbackend.moc"